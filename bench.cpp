@@ -0,0 +1,380 @@
+// Self-contained microbenchmarks for the cache, worker queue, line parser and DB layers.
+// Build and run with `make bench`; results are written as JSON or CSV.
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <fstream>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include "util.hpp"
+#include "config.hpp"
+#include "conn_table.hpp"
+#include "worker_pool.hpp"
+#include "db.hpp"
+#include "lru_cache.hpp"
+#include "parser.hpp"
+#include "hash_ring.hpp"
+
+int g_epoll_fd = -1;
+
+struct BenchResult {
+    std::string bench;
+    std::vector<std::pair<std::string,std::string>> params;
+    uint64_t ops = 0;
+    double seconds = 0;
+};
+
+struct BenchOpts {
+    std::string format = "json";
+    std::string out;
+    std::string cfg_path = "server.conf";
+    std::string db_mode = "stub"; // stub | mariadb (writes bench_key* rows to kv)
+    bool quick = false;
+};
+
+static inline uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::vector<std::string> make_keys(size_t n, uint32_t seed) {
+    std::vector<std::string> keys; keys.reserve(n);
+    std::mt19937 rng(seed);
+    for (size_t i=0;i<n;i++) keys.push_back("key" + std::to_string(rng() % (n * 4)));
+    return keys;
+}
+
+// In-memory backend with the same get/put contract as DB; the default for the DB benchmark.
+class StubDB : public DB {
+public:
+    bool get(const std::string &k, std::string &out, std::string &err) override {
+        std::lock_guard<std::mutex> g(mtx);
+        auto it = m.find(k);
+        if (it == m.end()) { err = "not found"; return false; }
+        out = it->second;
+        return true;
+    }
+    bool put(const std::string &k, const std::string &v, std::string &) override {
+        std::lock_guard<std::mutex> g(mtx);
+        m[k] = v;
+        return true;
+    }
+private:
+    std::mutex mtx;
+    std::unordered_map<std::string,std::string> m;
+};
+
+// ---------- LRUCache ----------
+
+static BenchResult bench_cache(bool do_put, int shards, int threads, size_t cap_bytes, uint64_t ops_per_thread) {
+    LRUCache cache(shards, cap_bytes);
+    const size_t nkeys = 10000;
+    auto keys = make_keys(nkeys, 42);
+    std::string val(100, 'v');
+    for (auto &k: keys) cache.put(k, val);
+
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> ts;
+    for (int t=0;t<threads;t++) {
+        ts.emplace_back([&, t]{
+            std::string out;
+            size_t idx = (size_t)t * 7919;
+            ready++;
+            while (!go) std::this_thread::yield();
+            for (uint64_t i=0;i<ops_per_thread;i++) {
+                const std::string &k = keys[(idx + i) % nkeys];
+                if (do_put) cache.put(k, val);
+                else cache.get(k, out);
+            }
+        });
+    }
+    while (ready < threads) std::this_thread::yield();
+    uint64_t t0 = now_ns();
+    go = true;
+    for (auto &th: ts) th.join();
+    uint64_t t1 = now_ns();
+
+    BenchResult r;
+    r.bench = do_put ? "lru_put" : "lru_get";
+    r.params = {{"shards", std::to_string(shards)}, {"threads", std::to_string(threads)},
+                {"capacity_bytes", std::to_string(cap_bytes)}};
+    r.ops = ops_per_thread * threads;
+    r.seconds = (t1 - t0) / 1e9;
+    return r;
+}
+
+// ---------- WorkerPool ----------
+
+static size_t total_responses(ConnTable &ct) {
+    std::lock_guard<std::mutex> g(ct.mtx);
+    size_t n = 0;
+    for (auto &kv: ct.map) n += kv.second.outq.size();
+    return n;
+}
+
+static BenchResult bench_pool(int workers, int clients, uint64_t jobs) {
+    StubDB db;
+    std::string err;
+    for (int i=0;i<1000;i++) db.put("key" + std::to_string(i), "value" + std::to_string(i), err);
+
+    ConnTable ct;
+    std::vector<int> peer_fds;
+    std::vector<Conn*> conns;
+    for (int c=0;c<clients;c++) {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) { perror("socketpair"); break; }
+        epoll_event ev{}; ev.events = EPOLLIN; ev.data.fd = sv[0];
+        if (epoll_ctl(g_epoll_fd, EPOLL_CTL_ADD, sv[0], &ev) < 0) {
+            log_error(std::string("epoll_ctl ADD client failed: ") + strerror(errno));
+            close(sv[0]); close(sv[1]);
+            continue;
+        }
+        ct.add(sv[0]);
+        conns.push_back(ct.get_ptr(sv[0]));
+        peer_fds.push_back(sv[0]); peer_fds.push_back(sv[1]);
+    }
+    if (conns.empty()) {
+        log_error("pool_dispatch: could not set up any client sockets");
+        exit(1);
+    }
+
+    ServerConfig cfg;
+    cfg.cache_enabled = false;
+    cfg.pin_workers = false;
+
+    uint64_t t0, t1;
+    {
+        WorkerPool pool(workers, &db, &ct, nullptr, cfg);
+        t0 = now_ns();
+        for (uint64_t i=0;i<jobs;i++) {
+            Job j;
+            j.type = Job::GET;
+            Conn *cp = conns[i % conns.size()];
+            j.client_fd = cp->fd;
+            j.conn_id = cp->id;
+            j.seq = cp->next_seq++;
+            j.key = "key" + std::to_string(i % 1000);
+            j.enqueue_ts = now_ms();
+            pool.push_job(j);
+        }
+        while (total_responses(ct) < jobs) std::this_thread::sleep_for(std::chrono::microseconds(50));
+        t1 = now_ns();
+    }
+
+    for (size_t i=0;i<peer_fds.size();i++) {
+        if (i % 2 == 0) epoll_ctl(g_epoll_fd, EPOLL_CTL_DEL, peer_fds[i], nullptr);
+        close(peer_fds[i]);
+    }
+
+    BenchResult r;
+    r.bench = "pool_dispatch";
+    r.params = {{"workers", std::to_string(workers)}, {"clients", std::to_string(clients)}, {"backend", "stub"}};
+    r.ops = jobs;
+    r.seconds = (t1 - t0) / 1e9;
+    return r;
+}
+
+// ---------- line parser (EPOLLIN path) ----------
+
+static BenchResult bench_parser(bool crlf, uint64_t lines) {
+    std::string stream;
+    std::mt19937 rng(7);
+    const char *eol = crlf ? "\r\n" : "\n";
+    for (uint64_t i=0;i<lines;i++) {
+        std::string k = "key" + std::to_string(rng() % 100000);
+        if (i % 10 == 0) stream += "PUT " + k + " value" + std::to_string(i) + eol;
+        else stream += "GET " + k + eol;
+    }
+
+    std::string inbuf, line;
+    uint64_t parsed = 0;
+    uint64_t t0 = now_ns();
+    // feed in recv()-sized pieces, exactly like main.cpp does
+    for (size_t off = 0; off < stream.size(); off += 4096) {
+        inbuf.append(stream, off, 4096);
+        while (next_line(inbuf, line)) {
+            Job j;
+            if (parse_command(line, j)) parsed++;
+        }
+    }
+    uint64_t t1 = now_ns();
+
+    BenchResult r;
+    r.bench = "parser";
+    r.params = {{"eol", crlf ? "crlf" : "lf"}, {"bytes", std::to_string(stream.size())}};
+    r.ops = parsed;
+    r.seconds = (t1 - t0) / 1e9;
+    return r;
+}
+
+// ---------- consistent-hash ring (kv_proxy routing) ----------
+
+static BenchResult bench_ring(int nodes, int vnodes, uint64_t lookups) {
+    std::vector<std::string> names;
+    for (int i=0;i<nodes;i++) names.push_back("127.0.0.1:" + std::to_string(8081 + i));
+    HashRing ring = build_ring(names, vnodes);
+    auto keys = make_keys(10000, 11);
+
+    size_t sink = 0;
+    uint64_t t0 = now_ns();
+    for (uint64_t i=0;i<lookups;i++) sink += ring.node_for(keys[i % keys.size()]).size();
+    uint64_t t1 = now_ns();
+    volatile size_t keep = sink; (void)keep;  // stop the loop being optimised out
+
+    BenchResult r;
+    r.bench = "ring_lookup";
+    r.params = {{"nodes", std::to_string(nodes)}, {"vnodes", std::to_string(vnodes)}};
+    r.ops = lookups;
+    r.seconds = (t1 - t0) / 1e9;
+    return r;
+}
+
+// ---------- DB round trips ----------
+
+static BenchResult bench_db(DB &db, const std::string &backend, bool do_put, uint64_t ops) {
+    std::string out, err;
+    uint64_t t0 = now_ns();
+    for (uint64_t i=0;i<ops;i++) {
+        std::string k = "bench_key" + std::to_string(i % 256);
+        if (do_put) db.put(k, "bench_value" + std::to_string(i), err);
+        else db.get(k, out, err);
+    }
+    uint64_t t1 = now_ns();
+
+    BenchResult r;
+    r.bench = do_put ? "db_put" : "db_get";
+    r.params = {{"backend", backend}};
+    r.ops = ops;
+    r.seconds = (t1 - t0) / 1e9;
+    return r;
+}
+
+// ---------- output ----------
+
+static std::string json_escape(const std::string &s) {
+    std::string o;
+    for (char c: s) {
+        if (c == '"' || c == '\\') { o += '\\'; o += c; }
+        else if ((unsigned char)c < 0x20) { char b[8]; snprintf(b, sizeof(b), "\\u%04x", c); o += b; }
+        else o += c;
+    }
+    return o;
+}
+
+static void write_json(std::ostream &os, const std::vector<BenchResult> &rs) {
+    os << "{\n  \"results\": [\n";
+    for (size_t i=0;i<rs.size();i++) {
+        const BenchResult &r = rs[i];
+        double ops_s = r.seconds > 0 ? r.ops / r.seconds : 0;
+        double ns_op = r.ops > 0 ? r.seconds * 1e9 / r.ops : 0;
+        os << "    {\"bench\": \"" << json_escape(r.bench) << "\", \"params\": {";
+        for (size_t p=0;p<r.params.size();p++) {
+            if (p) os << ", ";
+            os << "\"" << json_escape(r.params[p].first) << "\": \"" << json_escape(r.params[p].second) << "\"";
+        }
+        os << "}, \"ops\": " << r.ops << ", \"seconds\": " << r.seconds
+           << ", \"ops_per_sec\": " << (uint64_t)ops_s << ", \"ns_per_op\": " << ns_op << "}"
+           << (i + 1 < rs.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+}
+
+static void write_csv(std::ostream &os, const std::vector<BenchResult> &rs) {
+    os << "bench,params,ops,seconds,ops_per_sec,ns_per_op\n";
+    for (auto &r: rs) {
+        std::string ps;
+        for (auto &p: r.params) { if (!ps.empty()) ps += ';'; ps += p.first + "=" + p.second; }
+        double ops_s = r.seconds > 0 ? r.ops / r.seconds : 0;
+        double ns_op = r.ops > 0 ? r.seconds * 1e9 / r.ops : 0;
+        os << r.bench << "," << ps << "," << r.ops << "," << r.seconds << ","
+           << (uint64_t)ops_s << "," << ns_op << "\n";
+    }
+}
+
+static void usage(const char *prog) {
+    std::cerr << "usage: " << prog
+              << " [--format=json|csv] [--out=FILE] [--config=FILE] [--db=stub|mariadb] [--quick]\n";
+    exit(2);
+}
+
+static BenchOpts parse_args(int argc, char **argv) {
+    BenchOpts o;
+    for (int i=1;i<argc;i++) {
+        std::string a = argv[i];
+        if (a.rfind("--format=", 0) == 0) o.format = a.substr(9);
+        else if (a.rfind("--out=", 0) == 0) o.out = a.substr(6);
+        else if (a.rfind("--config=", 0) == 0) o.cfg_path = a.substr(9);
+        else if (a.rfind("--db=", 0) == 0) o.db_mode = a.substr(5);
+        else if (a == "--quick") o.quick = true;
+        else usage(argv[0]);
+    }
+    if (o.format != "json" && o.format != "csv") usage(argv[0]);
+    if (o.db_mode != "stub" && o.db_mode != "mariadb") usage(argv[0]);
+    return o;
+}
+
+int main(int argc, char **argv) {
+    BenchOpts opt = parse_args(argc, argv);
+    ServerConfig cfg = load_config_file(opt.cfg_path);
+    set_log_level("error");
+
+    g_epoll_fd = epoll_create1(0);
+    if (g_epoll_fd < 0) { perror("epoll_create1"); return 1; }
+
+    uint64_t scale = opt.quick ? 1 : 10;
+    std::vector<BenchResult> results;
+
+    size_t cap = (size_t)cfg.cache_size_mb * 1024 * 1024;
+    for (int shards: {1, 4, 16}) {
+        for (int threads: {1, 2, 4, 8}) {
+            results.push_back(bench_cache(false, shards, threads, cap, 20000 * scale));
+            results.push_back(bench_cache(true, shards, threads, cap, 20000 * scale));
+        }
+    }
+
+    for (int workers: {1, 2, 4})
+        results.push_back(bench_pool(workers, 16, 20000 * scale));
+
+    results.push_back(bench_parser(false, 50000 * scale));
+    results.push_back(bench_parser(true, 50000 * scale));
+
+    for (int nodes: {3, 16})
+        results.push_back(bench_ring(nodes, 160, 50000 * scale));
+
+    StubDB stub;
+    DB real;
+    DB *db = &stub;
+    std::string backend = "stub";
+    // only touch the configured database when explicitly asked to
+    if (opt.db_mode == "mariadb") {
+        if (!real.connect(cfg.db_host.c_str(), cfg.db_user.c_str(), cfg.db_pass.c_str(), cfg.db_name.c_str())) {
+            log_error("MariaDB requested but connect failed");
+            return 1;
+        }
+        db = &real; backend = "mariadb";
+    }
+    uint64_t db_ops = backend == "stub" ? 20000 * scale : 200 * scale;
+    results.push_back(bench_db(*db, backend, true, db_ops));
+    results.push_back(bench_db(*db, backend, false, db_ops));
+
+    close(g_epoll_fd);
+
+    std::ofstream f;
+    if (!opt.out.empty()) {
+        f.open(opt.out);
+        if (!f.is_open()) { log_error("cannot open " + opt.out); return 1; }
+    }
+    std::ostream &os = opt.out.empty() ? std::cout : f;
+    if (opt.format == "csv") write_csv(os, results);
+    else write_json(os, results);
+    return 0;
+}
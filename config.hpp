@@ -4,6 +4,7 @@
 #include <fstream>
 #include <algorithm>
 #include <cctype>
+#include <vector>
 
 static inline std::string trim(const std::string &s) {
     size_t a=0,b=s.size();
@@ -12,6 +13,20 @@ static inline std::string trim(const std::string &s) {
     return s.substr(a,b-a);
 }
 
+// split "a, b,c" into {"a","b","c"}, dropping empty entries
+static inline std::vector<std::string> split_list(const std::string &s, char sep = ',') {
+    std::vector<std::string> out;
+    size_t p = 0;
+    while (p <= s.size()) {
+        size_t e = s.find(sep, p);
+        if (e == std::string::npos) e = s.size();
+        std::string item = trim(s.substr(p, e-p));
+        if (!item.empty()) out.push_back(item);
+        p = e + 1;
+    }
+    return out;
+}
+
 struct ServerConfig {
     int port = 8080;
     int worker_threads = 3;
@@ -27,6 +42,20 @@ struct ServerConfig {
     int mix_get_percent = 90;
     std::string log_level = "info";
     int max_conn_queue = 128;
+    int scan_chunk_rows = 128;
+    int scan_outq_high_kb = 256;
+    // cluster mode: every instance lists all nodes; cluster_self is this one's entry
+    std::string cluster_nodes = "";
+    std::string cluster_self = "";
+    int cluster_vnodes = 160;
+};
+
+struct ProxyConfig {
+    int port = 9090;
+    std::string cluster_nodes = "";
+    int cluster_vnodes = 160;
+    std::string log_level = "info";
+    int max_conn_queue = 128;
 };
 
 static inline std::unordered_map<std::string,std::string> parse_kv_file(const std::string &path) {
@@ -74,5 +103,21 @@ static inline ServerConfig load_config_file(const std::string &path) {
     cfg.mix_get_percent = stoi_def(m,"mix_get_percent", cfg.mix_get_percent);
     cfg.log_level = str_def(m,"log_level", cfg.log_level);
     cfg.max_conn_queue = stoi_def(m,"max_conn_queue", cfg.max_conn_queue);
+    cfg.scan_chunk_rows = std::max(1, stoi_def(m,"scan_chunk_rows", cfg.scan_chunk_rows));
+    cfg.scan_outq_high_kb = std::max(1, stoi_def(m,"scan_outq_high_kb", cfg.scan_outq_high_kb));
+    cfg.cluster_nodes = str_def(m,"cluster_nodes", cfg.cluster_nodes);
+    cfg.cluster_self = str_def(m,"cluster_self", cfg.cluster_self);
+    cfg.cluster_vnodes = std::max(1, stoi_def(m,"cluster_vnodes", cfg.cluster_vnodes));
+    return cfg;
+}
+
+static inline ProxyConfig load_proxy_config_file(const std::string &path) {
+    ProxyConfig cfg;
+    auto m = parse_kv_file(path);
+    cfg.port = stoi_def(m,"port",cfg.port);
+    cfg.cluster_nodes = str_def(m,"cluster_nodes", cfg.cluster_nodes);
+    cfg.cluster_vnodes = std::max(1, stoi_def(m,"cluster_vnodes", cfg.cluster_vnodes));
+    cfg.log_level = str_def(m,"log_level", cfg.log_level);
+    cfg.max_conn_queue = stoi_def(m,"max_conn_queue", cfg.max_conn_queue);
     return cfg;
 }
@@ -1,10 +1,73 @@
 #pragma once
 #include <string>
 #include <deque>
+#include <map>
+#include <vector>
+#include "job.hpp"
 
 struct Conn {
     int fd = -1;
+    uint64_t id = 0;        // unique per accept, guards against fd reuse
     std::string inbuf;
     std::deque<std::string> outq;
+    size_t outq_bytes = 0;
     bool want_write = false;
+
+    // responses enter outq in request order; ones that finish early wait in `ready`
+    uint64_t next_seq = 0;  // assigned by the reactor per parsed command
+    uint64_t send_seq = 0;  // seq whose output may go to outq now
+    std::map<uint64_t, std::pair<std::string,bool>> ready; // seq -> (data, complete)
+
+    // SCAN continuations waiting for the client to drain its output
+    std::vector<Job> parked;
+
+    // queue output for request `seq`; `done` marks its last piece. true if outq grew
+    bool deliver(uint64_t seq, std::string data, bool done) {
+        if (seq != send_seq) {
+            auto &r = ready[seq];
+            r.first += data;
+            r.second = done;
+            return false;
+        }
+        bool added = push_out(std::move(data));
+        if (!done) return added;
+        ++send_seq;
+        while (true) {
+            auto it = ready.find(send_seq);
+            if (it == ready.end()) break;
+            bool fin = it->second.second;
+            added |= push_out(std::move(it->second.first));
+            ready.erase(it);
+            if (!fin) break;
+            ++send_seq;
+        }
+        return added;
+    }
+
+    // bytes produced for `seq` that the client has not read yet
+    size_t buffered_for(uint64_t seq) const {
+        if (seq == send_seq) return outq_bytes;
+        auto it = ready.find(seq);
+        return it == ready.end() ? 0 : it->second.first.size();
+    }
+
+    // move parked scans whose output has drained to at most `low` bytes into out
+    void take_resumable(std::vector<Job> &out, size_t low) {
+        for (size_t i = 0; i < parked.size(); ) {
+            if (buffered_for(parked[i].seq) <= low) {
+                out.push_back(std::move(parked[i]));
+                parked.erase(parked.begin() + i);
+            } else {
+                ++i;
+            }
+        }
+    }
+
+private:
+    bool push_out(std::string data) {
+        if (data.empty()) return false;
+        outq_bytes += data.size();
+        outq.push_back(std::move(data));
+        return true;
+    }
 };
@@ -7,12 +7,14 @@ class ConnTable {
 public:
     std::unordered_map<int, Conn> map;
     std::mutex mtx;
+    uint64_t next_id = 1;
 
-    // create entry on accept
-    void add(int fd) {
+    // create entry on accept; returns the conn's unique id
+    uint64_t add(int fd) {
         std::lock_guard<std::mutex> g(mtx);
-        Conn c; c.fd = fd;
+        Conn c; c.fd = fd; c.id = next_id++;
         map[fd] = std::move(c);
+        return map[fd].id;
     }
     // remove entry on close
     void remove_fd(int fd) {
@@ -1,12 +1,15 @@
 #pragma once
 #include <mariadb/mysql.h>
 #include <string>
+#include <vector>
 #include "util.hpp"
 
 class DB {
 public:
     std::string host, user, pass, dbname;
 
+    virtual ~DB() = default;
+
     bool connect(const char *h, const char *u,
                  const char *p, const char *db)
     {
@@ -57,7 +60,8 @@ private:
     }
 
 public:
-    bool get(const std::string &k, std::string &out, std::string &err)
+    // virtual so a stub backend can stand in for MariaDB (see bench.cpp)
+    virtual bool get(const std::string &k, std::string &out, std::string &err)
     {
         MYSQL *c = new_conn();
         if (!c) { err="conn failed"; return false; }
@@ -87,7 +91,7 @@ public:
         return ok;
     }
 
-    bool put(const std::string &k, const std::string &v, std::string &err)
+    virtual bool put(const std::string &k, const std::string &v, std::string &err)
     {
         MYSQL *c = new_conn();
         if (!c) { err="conn failed"; return false; }
@@ -106,4 +110,78 @@ public:
         mysql_close(c);
         return true;
     }
+
+    // identifies the database behind this connection (server host:port/schema), so
+    // cluster nodes can confirm they share one
+    virtual bool identity(std::string &out, std::string &err)
+    {
+        MYSQL *c = new_conn();
+        if (!c) { err="conn failed"; return false; }
+
+        if (mysql_query(c, "SELECT CONCAT(@@hostname, ':', @@port, '/', DATABASE())") != 0) {
+            err = mysql_error(c);
+            mysql_close(c);
+            return false;
+        }
+
+        MYSQL_RES *res = mysql_store_result(c);
+        if (!res) {
+            err = mysql_error(c);
+            mysql_close(c);
+            return false;
+        }
+
+        MYSQL_ROW row = mysql_fetch_row(res);
+        bool ok = (row != nullptr && row[0] != nullptr);
+        if (ok) out = row[0];
+        else err = "no identity";
+
+        mysql_free_result(res);
+        mysql_close(c);
+        return ok;
+    }
+
+    // up to `limit` rows whose key starts with `prefix` and sorts after `after`
+    // ("" = from the first key of the prefix), in key order
+    virtual bool scan(const std::string &prefix, const std::string &after, size_t limit,
+                      std::vector<std::pair<std::string,std::string>> &rows, std::string &err)
+    {
+        MYSQL *c = new_conn();
+        if (!c) { err="conn failed"; return false; }
+
+        // escape LIKE wildcards, then the string itself
+        std::string pat;
+        for (char ch : prefix) {
+            if (ch == '%' || ch == '_' || ch == '\\') pat += '\\';
+            pat += ch;
+        }
+
+        std::string q = "SELECT k,v FROM kv WHERE ";
+        if (after.empty()) q += "k >= '" + esc(c, prefix) + "'";
+        else q += "k > '" + esc(c, after) + "'";
+        if (!prefix.empty()) q += " AND k LIKE '" + esc(c, pat) + "%'";
+        q += " ORDER BY k LIMIT " + std::to_string(limit);
+
+        if (mysql_query(c, q.c_str()) != 0) {
+            err = mysql_error(c);
+            mysql_close(c);
+            return false;
+        }
+
+        MYSQL_RES *res = mysql_store_result(c);
+        if (!res) {
+            err = mysql_error(c);
+            mysql_close(c);
+            return false;
+        }
+
+        rows.clear();
+        MYSQL_ROW row;
+        while ((row = mysql_fetch_row(res)) != nullptr)
+            rows.emplace_back(row[0], row[1] ? row[1] : "");
+
+        mysql_free_result(res);
+        mysql_close(c);
+        return true;
+    }
 };
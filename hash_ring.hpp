@@ -0,0 +1,65 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// stable 64-bit hash (FNV-1a + murmur3 finaliser): unlike std::hash it is the same in
+// every build, so kv_server and kv_proxy always agree on the ring
+static inline uint64_t ring_hash(const std::string &s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : s) { h ^= c; h *= 1099511628211ULL; }
+    h ^= h >> 33; h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// consistent-hash ring with virtual nodes. Each node owns the arcs ending at its
+// `vnodes` points, so adding a node to N-1 others only remaps about 1/N of the keys.
+class HashRing {
+public:
+    explicit HashRing(int vnodes_ = 160) : vnodes(std::max(1, vnodes_)) {}
+
+    void add_node(const std::string &node) {
+        if (contains(node)) return;
+        members.push_back(node);
+        add_points(node);
+    }
+
+    bool contains(const std::string &node) const {
+        return std::find(members.begin(), members.end(), node) != members.end();
+    }
+    bool empty() const { return points.empty(); }
+    const std::vector<std::string> &nodes() const { return members; }
+
+    // owner of key; ring must not be empty
+    const std::string &node_for(const std::string &key) const {
+        auto it = points.lower_bound(ring_hash(key));
+        if (it == points.end()) it = points.begin();
+        return it->second;
+    }
+
+private:
+    int vnodes;
+    std::map<uint64_t, std::string> points;
+    std::vector<std::string> members;
+
+    void add_points(const std::string &node) {
+        for (int i = 0; i < vnodes; i++) {
+            uint64_t h = ring_hash(node + "#" + std::to_string(i));
+            auto it = points.find(h);
+            // on collision the smaller name wins, independent of insertion order
+            if (it == points.end()) points.emplace(h, node);
+            else if (node < it->second) it->second = node;
+        }
+    }
+};
+
+// ring over the given "host:port" node names
+static inline HashRing build_ring(const std::vector<std::string> &nodes, int vnodes) {
+    HashRing r(vnodes);
+    for (auto &n : nodes) r.add_node(n);
+    return r;
+}
@@ -1,9 +1,14 @@
 #pragma once
 #include <string>
+#include <cstdint>
 struct Job {
-    enum Type { GET=0, PUT=1 } type;
+    enum Type { GET=0, PUT=1, SCAN=2, DBID=3 } type;
     int client_fd = -1;
-    std::string key;
+    uint64_t conn_id = 0;
+    uint64_t seq = 0;        // position in the connection's response order
+    std::string key;         // SCAN: key prefix
     std::string value;
+    std::string cursor;      // SCAN: resume after this key, "" = start of prefix
+    int64_t remaining = -1;  // SCAN: rows still to return, -1 = no limit
     uint64_t enqueue_ts = 0;
 };
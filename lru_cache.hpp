@@ -5,6 +5,7 @@
 #include <list>
 #include <unordered_map>
 #include <string>
+#include "util.hpp"
 
 struct LRUCacheShard {
     std::mutex mtx;
@@ -79,4 +80,22 @@ public:
             shard->lru.pop_back();
         }
     }
+
+    // drop every entry whose key matches pred; returns how many were removed
+    template <class Pred>
+    size_t erase_if(Pred pred) {
+        size_t n = 0;
+        for (auto &sp : shards) {
+            LRUCacheShard *shard = sp.get();
+            std::lock_guard<std::mutex> lock(shard->mtx);
+            for (auto it = shard->lru.begin(); it != shard->lru.end(); ) {
+                if (!pred(it->first)) { ++it; continue; }
+                shard->current_bytes -= (it->first.size() + it->second.size() + 32);
+                shard->map.erase(it->first);
+                it = shard->lru.erase(it);
+                n++;
+            }
+        }
+        return n;
+    }
 };
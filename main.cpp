@@ -15,10 +15,14 @@
 #include "worker_pool.hpp"
 #include "db.hpp"
 #include "lru_cache.hpp"
+#include "parser.hpp"
+#include "hash_ring.hpp"
 
 int g_epoll_fd = -1;
 static volatile bool g_running = true;
+static volatile bool g_reload = false;
 static void sigint_handler(int) { g_running = false; }
+static void sighup_handler(int) { g_reload = true; }
 
 static int set_nonblocking(int fd) {
     int flags = fcntl(fd, F_GETFL, 0);
@@ -40,17 +44,60 @@ static void pin_main_thread(const ServerConfig &cfg) {
     }
 }
 
+// answer a command from the reactor thread itself (e.g. a cluster redirect)
+static void reply_now(ConnTable &ct, int ep, int fd, uint64_t seq, const std::string &msg) {
+    std::lock_guard<std::mutex> g(ct.mtx);
+    Conn* cp = ct.get_ptr_unlocked(fd);
+    if (!cp || !cp->deliver(seq, msg, true) || cp->want_write) return;
+    cp->want_write = true;
+    epoll_event ne{}; ne.events = EPOLLIN | EPOLLOUT; ne.data.fd = fd;
+    if (epoll_ctl(ep, EPOLL_CTL_MOD, fd, &ne) < 0) {
+        log_error("epoll_ctl MOD enable EPOLLOUT failed for fd=" + std::to_string(fd));
+    }
+}
+
+// ring for cfg's cluster settings; false (error logged) if cluster_nodes is empty or
+// does not list cluster_self
+static bool load_cluster_ring(const ServerConfig &cfg, HashRing &out) {
+    HashRing ring = build_ring(split_list(cfg.cluster_nodes), cfg.cluster_vnodes);
+    if (ring.empty()) {
+        log_error("cluster_nodes is empty");
+        return false;
+    }
+    if (!ring.contains(cfg.cluster_self)) {
+        log_error("cluster_self '" + cfg.cluster_self + "' not in cluster_nodes");
+        return false;
+    }
+    log_info("Cluster mode: " + std::to_string(ring.nodes().size()) + " nodes, self=" + cfg.cluster_self);
+    out = ring;
+    return true;
+}
+
+// true if this node serves key under ring (an empty ring means standalone: every key)
+static bool owns_key(const HashRing &ring, const std::string &self, const std::string &key) {
+    return ring.empty() || ring.node_for(key) == self;
+}
+
 int main(int argc, char** argv) {
     std::string cfg_path = "server.conf";
     if (argc > 1) cfg_path = argv[1];
 
     ServerConfig cfg = load_config_file(cfg_path);
+    set_log_level(cfg.log_level);
     log_info("Config: port=" + std::to_string(cfg.port) + " workers=" + std::to_string(cfg.worker_threads)
              + " cache=" + (cfg.cache_enabled?"on":"off") + " cache_mb=" + std::to_string(cfg.cache_size_mb)
              + " pin_workers=" + (cfg.pin_workers ? "true":"false"));
 
     signal(SIGINT, sigint_handler);
     signal(SIGTERM, sigint_handler);
+    signal(SIGHUP, sighup_handler);
+
+    // cluster ring; standalone (empty ring) only when cluster_nodes is not set
+    HashRing ring;
+    if (!split_list(cfg.cluster_nodes).empty() && !load_cluster_ring(cfg, ring)) {
+        log_error("Invalid cluster config. Exiting.");
+        return 1;
+    }
 
     // DB init
     DB db;
@@ -90,10 +137,40 @@ int main(int argc, char** argv) {
 
     log_info("Server listening on port " + std::to_string(cfg.port));
 
+    // parked SCANs resume once their unread output drops to a quarter of the high mark
+    const size_t scan_low_bytes = (size_t)cfg.scan_outq_high_kb * 1024 / 4;
+
     const int MAX_EVENTS = 256;
     std::vector<epoll_event> events(MAX_EVENTS);
 
     while (g_running) {
+        if (g_reload) {
+            // SIGHUP: pick up cluster membership changes (node added/removed)
+            g_reload = false;
+            ServerConfig ncfg = load_config_file(cfg_path);
+            HashRing new_ring;
+            if (!load_cluster_ring(ncfg, new_ring)) {
+                // an invalid reload must not turn the node standalone: it would serve
+                // and cache keys other nodes own
+                log_error("reload: keeping current ring");
+                continue;
+            }
+            std::string old_self = cfg.cluster_self;
+            cfg.cluster_nodes = ncfg.cluster_nodes;
+            cfg.cluster_self = ncfg.cluster_self;
+            cfg.cluster_vnodes = ncfg.cluster_vnodes;
+            HashRing old_ring = ring;
+            ring = new_ring;
+            // Only entries this node owned before and after the change are known fresh;
+            // a key owned elsewhere in between may have been rewritten through that node.
+            if (cfg.cache_enabled) {
+                size_t dropped = cache.erase_if([&](const std::string &k) {
+                    return !owns_key(old_ring, old_self, k) || !owns_key(ring, cfg.cluster_self, k);
+                });
+                log_info("Ring change: dropped " + std::to_string(dropped) + " cache entries");
+            }
+        }
+
         int n = epoll_wait(ep, events.data(), MAX_EVENTS, 1000);
         if (n < 0) { if (errno == EINTR) continue; perror("epoll_wait"); break; }
         if (n == 0) continue;
@@ -140,24 +217,19 @@ int main(int argc, char** argv) {
                     ssize_t r = recv(fd, buf, sizeof(buf), 0);
                     if (r > 0) {
                         cp->inbuf.append(buf, r);
-                        size_t pos;
-                        while ((pos = cp->inbuf.find('\n')) != std::string::npos) {
-                            std::string line = cp->inbuf.substr(0, pos);
-                            cp->inbuf.erase(0, pos+1);
-                            if (!line.empty() && line.back() == '\r') {
-                                line.pop_back();
-                                log_info("PARSER: stripped CR");
-                            }
-                            log_info("PARSER: '" + line + "'");
+                        std::string line;
+                        while (next_line(cp->inbuf, line)) {
                             Job j; j.client_fd = fd; j.enqueue_ts = now_ms();
-                            if (line.rfind("GET ", 0) == 0) {
-                                j.type = Job::GET; j.key = line.substr(4); pool.push_job(j);
-                            } else if (line.rfind("PUT ", 0) == 0) {
-                                size_t sp = line.find(' ', 4);
-                                if (sp == std::string::npos) continue;
-                                j.type = Job::PUT;
-                                j.key = line.substr(4, sp-4);
-                                j.value = line.substr(sp+1);
+                            if (parse_command(line, j)) {
+                                j.conn_id = cp->id;
+                                j.seq = cp->next_seq++;
+                                if ((j.type == Job::GET || j.type == Job::PUT) && !ring.empty()) {
+                                    const std::string &owner = ring.node_for(j.key);
+                                    if (owner != cfg.cluster_self) {
+                                        reply_now(ct, ep, fd, j.seq, "ERR MOVED " + owner + "\n");
+                                        continue;
+                                    }
+                                }
                                 pool.push_job(j);
                             } else {
                                 log_info("Unknown command: '" + line + "'");
@@ -177,27 +249,37 @@ int main(int argc, char** argv) {
             }
 
             if (evs & EPOLLOUT) {
-                Conn* cp = ct.get_ptr(fd);
-                if (!cp) { log_info("EPOLLOUT but no conn for fd=" + std::to_string(fd)); continue; }
-                std::lock_guard<std::mutex> g(ct.mtx);
-                while (!cp->outq.empty()) {
-                    std::string &msg = cp->outq.front();
-                    ssize_t w = send(fd, msg.data(), msg.size(), 0);
-                    if (w < 0) {
-                        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
-                        log_error("send failed: " + std::string(strerror(errno)));
-                        close(fd); ct.remove_fd(fd); break;
+                std::vector<Job> resume;
+                {
+                    std::lock_guard<std::mutex> g(ct.mtx);
+                    Conn* cp = ct.get_ptr_unlocked(fd);
+                    if (!cp) { log_info("EPOLLOUT but no conn for fd=" + std::to_string(fd)); continue; }
+                    bool closed = false;
+                    while (!cp->outq.empty()) {
+                        std::string &msg = cp->outq.front();
+                        ssize_t w = send(fd, msg.data(), msg.size(), 0);
+                        if (w < 0) {
+                            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                            log_error("send failed: " + std::string(strerror(errno)));
+                            // already holding ct.mtx, so erase directly rather than remove_fd()
+                            close(fd); ct.map.erase(fd); closed = true; break;
+                        }
+                        cp->outq_bytes -= (size_t)w;
+                        if ((size_t)w < msg.size()) { msg.erase(0, w); break; }
+                        cp->outq.pop_front();
                     }
-                    if ((size_t)w < msg.size()) { msg.erase(0, w); break; }
-                    cp->outq.pop_front();
-                }
-                if (cp->outq.empty()) {
-                    cp->want_write = false;
-                    epoll_event ne{}; ne.events = EPOLLIN; ne.data.fd = fd;
-                    if (epoll_ctl(ep, EPOLL_CTL_MOD, fd, &ne) < 0) {
-                        log_error("epoll_ctl MOD disable EPOLLOUT failed for fd=" + std::to_string(fd));
+                    if (closed) continue;
+                    if (cp->outq.empty()) {
+                        cp->want_write = false;
+                        epoll_event ne{}; ne.events = EPOLLIN; ne.data.fd = fd;
+                        if (epoll_ctl(ep, EPOLL_CTL_MOD, fd, &ne) < 0) {
+                            log_error("epoll_ctl MOD disable EPOLLOUT failed for fd=" + std::to_string(fd));
+                        }
                     }
+                    // client has caught up: let parked SCANs stream again
+                    if (!cp->parked.empty()) cp->take_resumable(resume, scan_low_bytes);
                 }
+                for (auto &j : resume) pool.push_job(j);
             }
         } // for events
     } // while running
@@ -0,0 +1,64 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "job.hpp"
+#include "util.hpp"
+
+// pop one '\n'-terminated line off inbuf (CR stripped); false if none complete yet
+static inline bool next_line(std::string &inbuf, std::string &line) {
+    size_t pos = inbuf.find('\n');
+    if (pos == std::string::npos) return false;
+    line = inbuf.substr(0, pos);
+    inbuf.erase(0, pos+1);
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+        log_info("PARSER: stripped CR");
+    }
+    return true;
+}
+
+// fill type/key/value of j from one command line; false if not a valid command
+static inline bool parse_command(const std::string &line, Job &j) {
+    log_info("PARSER: '" + line + "'");
+    if (line.rfind("GET ", 0) == 0) {
+        j.type = Job::GET; j.key = line.substr(4);
+        return true;
+    }
+    if (line.rfind("PUT ", 0) == 0) {
+        size_t sp = line.find(' ', 4);
+        if (sp == std::string::npos) return false;
+        j.type = Job::PUT;
+        j.key = line.substr(4, sp-4);
+        j.value = line.substr(sp+1);
+        return true;
+    }
+    // DBID: which backing database this node uses (kv_proxy checks they all match)
+    if (line == "DBID") {
+        j.type = Job::DBID;
+        return true;
+    }
+    // SCAN [prefix [limit [cursor]]]; prefix "*" = whole keyspace, limit 0 = no limit
+    if (line == "SCAN" || line.rfind("SCAN ", 0) == 0) {
+        std::vector<std::string> tok;
+        size_t p = 4;
+        while (p < line.size()) {
+            if (line[p] == ' ') { ++p; continue; }
+            size_t e = line.find(' ', p);
+            if (e == std::string::npos) e = line.size();
+            tok.push_back(line.substr(p, e-p));
+            p = e;
+        }
+        if (tok.size() > 3) return false;
+        j.type = Job::SCAN;
+        j.key = (tok.size() > 0 && tok[0] != "*") ? tok[0] : "";
+        j.remaining = -1;
+        if (tok.size() > 1) {
+            if (tok[1].empty() || tok[1].find_first_not_of("0123456789") != std::string::npos) return false;
+            try { j.remaining = std::stoll(tok[1]); } catch(...) { return false; }
+            if (j.remaining == 0) j.remaining = -1;
+        }
+        j.cursor = tok.size() > 2 ? tok[2] : "";
+        return true;
+    }
+    return false;
+}
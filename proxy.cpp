@@ -0,0 +1,603 @@
+// kv_proxy: speaks the kv_server GET/PUT protocol and forwards each command to the
+// node that owns the key on the consistent-hash ring, pipelining requests over one
+// persistent connection per backend. Edit cluster_nodes and send SIGHUP to add a node.
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+
+#include "util.hpp"
+#include "config.hpp"
+#include "conn.hpp"
+#include "parser.hpp"
+#include "hash_ring.hpp"
+
+static volatile bool g_running = true;
+static volatile bool g_reload = false;
+static void sigint_handler(int) { g_running = false; }
+static void sighup_handler(int) { g_reload = true; }
+
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0) flags = 0;
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+// one blocking request/reply round trip to a node, with a short timeout; only used by
+// start() before the event loop runs (reloads probe through the loop instead)
+static bool query_node(const std::string &addr, const std::string &req, std::string &reply) {
+    size_t colon = addr.rfind(':');
+    if (colon == std::string::npos) return false;
+    addrinfo hints{}; hints.ai_family = AF_INET; hints.ai_socktype = SOCK_STREAM;
+    addrinfo *res = nullptr;
+    if (getaddrinfo(addr.substr(0, colon).c_str(), addr.substr(colon+1).c_str(), &hints, &res) != 0 || !res)
+        return false;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) { freeaddrinfo(res); return false; }
+    timeval tv{}; tv.tv_sec = 2;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    bool ok = connect(fd, res->ai_addr, res->ai_addrlen) == 0
+              && send(fd, req.data(), req.size(), MSG_NOSIGNAL) == (ssize_t)req.size();
+    freeaddrinfo(res);
+    std::string buf;
+    while (ok && buf.find('\n') == std::string::npos) {
+        char tmp[512];
+        ssize_t r = recv(fd, tmp, sizeof(tmp), 0);
+        if (r <= 0) ok = false;
+        else buf.append(tmp, r);
+    }
+    close(fd);
+    if (!ok) return false;
+    next_line(buf, reply);
+    return true;
+}
+
+// Keys that change owner are not copied between nodes, so a ring is only accepted
+// when every node reports the same backing database (DBID). Blocking: startup only.
+static bool nodes_share_db(const HashRing &ring) {
+    std::string first_id, first_node;
+    for (auto &node : ring.nodes()) {
+        std::string reply;
+        if (!query_node(node, "DBID\n", reply) || reply.rfind("OK ", 0) != 0) {
+            log_error("cannot read DBID from node " + node + (reply.empty() ? "" : ": " + reply));
+            return false;
+        }
+        std::string id = reply.substr(3);
+        if (first_node.empty()) { first_id = id; first_node = node; continue; }
+        if (id != first_id) {
+            log_error("node " + node + " uses DB '" + id + "' but " + first_node + " uses '"
+                      + first_id + "'; cluster mode requires one shared DB");
+            return false;
+        }
+    }
+    return true;
+}
+
+// a request forwarded to a backend whose reply has not come back yet
+struct Pending {
+    int client_fd;
+    uint64_t conn_id;
+    uint64_t seq;
+    std::string req;          // the forwarded line, kept so a MOVED reply can be retried
+    bool redirected = false;  // already re-sent once after ERR MOVED
+    uint64_t probe = 0;       // non-zero: DBID probe for that reload generation, no client
+};
+
+// a reloaded ring waiting for every one of its nodes to report its DBID
+struct RingCandidate {
+    uint64_t gen = 0;                         // 0 = no reload in progress
+    ProxyConfig cfg;
+    HashRing ring;
+    std::map<std::string, std::string> ids;   // node -> DBID reported so far
+    uint64_t deadline_ms = 0;
+};
+
+struct Backend {
+    std::string addr;              // "host:port" as listed in cluster_nodes
+    int fd = -1;
+    bool connected = false;        // false while the non-blocking connect is in progress
+    uint32_t events = 0;           // currently registered epoll mask
+    std::string outbuf;            // requests not yet written
+    std::string inbuf;             // partial reply lines
+    std::deque<Pending> inflight;  // replies arrive in this order
+};
+
+class Proxy {
+public:
+    Proxy(const std::string &cfg_path_) : cfg_path(cfg_path_) {
+        cfg = load_proxy_config_file(cfg_path);
+        ring = build_ring(split_list(cfg.cluster_nodes), cfg.cluster_vnodes);
+    }
+
+    ~Proxy() {
+        for (auto &kv: clients) close(kv.first);
+        for (auto &kv: backends) if (kv.second.fd >= 0) close(kv.second.fd);
+        if (listen_fd >= 0) close(listen_fd);
+        if (ep >= 0) close(ep);
+    }
+
+    const ProxyConfig &config() const { return cfg; }
+
+    bool start() {
+        if (ring.empty()) { log_error("cluster_nodes is empty"); return false; }
+        if (!nodes_share_db(ring)) return false;
+        ep = epoll_create1(0);
+        if (ep < 0) { perror("epoll_create1"); return false; }
+
+        listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd < 0) { perror("socket"); return false; }
+        int yes = 1; setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+        sockaddr_in addr{}; addr.sin_family = AF_INET; addr.sin_port = htons(cfg.port); addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (bind(listen_fd, (sockaddr*)&addr, sizeof(addr)) < 0) { perror("bind"); return false; }
+        if (listen(listen_fd, cfg.max_conn_queue) < 0) { perror("listen"); return false; }
+        set_nonblocking(listen_fd);
+
+        epoll_event lev{}; lev.events = EPOLLIN; lev.data.fd = listen_fd;
+        if (epoll_ctl(ep, EPOLL_CTL_ADD, listen_fd, &lev) < 0) { perror("epoll_ctl add listen"); return false; }
+
+        log_info("Proxy listening on port " + std::to_string(cfg.port) + ", "
+                 + std::to_string(ring.nodes().size()) + " backends");
+        return true;
+    }
+
+    void run() {
+        const int MAX_EVENTS = 256;
+        std::vector<epoll_event> events(MAX_EVENTS);
+
+        while (g_running) {
+            if (g_reload) { g_reload = false; reload(); }
+
+            int n = epoll_wait(ep, events.data(), MAX_EVENTS, 1000);
+            if (n < 0) { if (errno == EINTR) continue; perror("epoll_wait"); break; }
+
+            for (int i=0;i<n;i++) {
+                int fd = events[i].data.fd;
+                uint32_t evs = events[i].events;
+                if (fd == listen_fd) { accept_clients(); continue; }
+                auto bit = backend_fds.find(fd);
+                if (bit != backend_fds.end()) on_backend_event(*bit->second, evs);
+                else on_client_event(fd, evs);
+            }
+
+            // one write per peer per loop, so requests from many clients share a send.
+            // swap the sets out first: flushing can fail a backend or close a client
+            std::unordered_set<Backend*> bs; bs.swap(dirty_backends);
+            for (Backend *b: bs) flush_backend(*b);
+            std::unordered_set<int> cs; cs.swap(dirty_clients);
+            for (int fd: cs) flush_client(fd);
+
+            if (cand.gen && now_ms() > cand.deadline_ms) {
+                log_error("reload: " + std::to_string(cand.ring.nodes().size() - cand.ids.size())
+                          + " node(s) did not answer DBID in time, keeping old ring");
+                cand = RingCandidate();
+                close_unused_backends();
+            }
+        }
+    }
+
+private:
+    std::string cfg_path;
+    ProxyConfig cfg;
+    HashRing ring;
+    int ep = -1;
+    int listen_fd = -1;
+    uint64_t next_conn_id = 1;
+    RingCandidate cand;
+    uint64_t next_gen = 1;
+
+    std::unordered_map<int, Conn> clients;
+    std::map<std::string, Backend> backends;        // by addr; node pointers stay valid
+    std::unordered_map<int, Backend*> backend_fds;
+    std::unordered_set<Backend*> dirty_backends;
+    std::unordered_set<int> dirty_clients;
+
+    void set_events(int fd, uint32_t evs) {
+        epoll_event ne{}; ne.events = evs; ne.data.fd = fd;
+        if (epoll_ctl(ep, EPOLL_CTL_MOD, fd, &ne) < 0) {
+            log_error("epoll_ctl MOD failed for fd=" + std::to_string(fd) + ": " + strerror(errno));
+        }
+    }
+
+    // ---------- clients ----------
+
+    void accept_clients() {
+        while (true) {
+            sockaddr_in cli{}; socklen_t clilen = sizeof(cli);
+            int c = accept(listen_fd, (sockaddr*)&cli, &clilen);
+            if (c < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                log_error(std::string("accept: ") + strerror(errno));
+                break;
+            }
+            set_nonblocking(c);
+            epoll_event cev{}; cev.events = EPOLLIN; cev.data.fd = c;
+            if (epoll_ctl(ep, EPOLL_CTL_ADD, c, &cev) < 0) {
+                log_error(std::string("epoll_ctl ADD client failed: ") + strerror(errno));
+                close(c);
+                continue;
+            }
+            Conn &cn = clients[c];
+            cn = Conn();
+            cn.fd = c; cn.id = next_conn_id++;
+            char ip[INET_ADDRSTRLEN]; inet_ntop(AF_INET, &cli.sin_addr, ip, sizeof(ip));
+            log_info("Accepted fd=" + std::to_string(c) + " from " + std::string(ip));
+        }
+    }
+
+    void close_client(int fd) {
+        close(fd);
+        clients.erase(fd);
+        dirty_clients.erase(fd);
+    }
+
+    void on_client_event(int fd, uint32_t evs) {
+        auto it = clients.find(fd);
+        if (it == clients.end()) return;
+        if (evs & (EPOLLERR | EPOLLHUP)) {
+            log_info("EPOLLERR/HUP on fd=" + std::to_string(fd) + " closing");
+            close_client(fd);
+            return;
+        }
+        if (evs & EPOLLIN) {
+            Conn &c = it->second;
+            while (true) {
+                char buf[4096];
+                ssize_t r = recv(fd, buf, sizeof(buf), 0);
+                if (r > 0) {
+                    c.inbuf.append(buf, r);
+                    std::string line;
+                    while (next_line(c.inbuf, line)) {
+                        Job j;
+                        if (!parse_command(line, j)) {
+                            log_info("Unknown command: '" + line + "'");
+                            continue;
+                        }
+                        route(c, j);
+                    }
+                } else if (r == 0) {
+                    log_info("Client closed fd=" + std::to_string(fd));
+                    close_client(fd);
+                    return;
+                } else {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                    log_error(std::string("recv error: ") + strerror(errno));
+                    close_client(fd);
+                    return;
+                }
+            }
+        }
+        if (evs & EPOLLOUT) flush_client(fd);
+    }
+
+    void reply(Conn &c, uint64_t seq, const std::string &msg) {
+        if (c.deliver(seq, msg, true)) dirty_clients.insert(c.fd);
+    }
+
+    void flush_client(int fd) {
+        auto it = clients.find(fd);
+        if (it == clients.end()) return;
+        Conn &c = it->second;
+        while (!c.outq.empty()) {
+            std::string &msg = c.outq.front();
+            ssize_t w = send(fd, msg.data(), msg.size(), MSG_NOSIGNAL);
+            if (w < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                log_error("send failed: " + std::string(strerror(errno)));
+                close_client(fd);
+                return;
+            }
+            c.outq_bytes -= (size_t)w;
+            if ((size_t)w < msg.size()) { msg.erase(0, w); break; }
+            c.outq.pop_front();
+        }
+        bool want = !c.outq.empty();
+        if (want != c.want_write) {
+            c.want_write = want;
+            set_events(fd, want ? (EPOLLIN | EPOLLOUT) : EPOLLIN);
+        }
+    }
+
+    void route(Conn &c, Job &j) {
+        uint64_t seq = c.next_seq++;
+        if (j.type != Job::GET && j.type != Job::PUT) {
+            reply(c, seq, std::string("ERR ") + (j.type == Job::SCAN ? "SCAN" : "DBID")
+                          + " not supported by kv_proxy\n");
+            return;
+        }
+        std::string req = (j.type == Job::GET) ? "GET " + j.key + "\n"
+                                                : "PUT " + j.key + " " + j.value + "\n";
+        forward(ring.node_for(j.key), Pending{c.fd, c.id, seq, req, false});
+    }
+
+    // queue p on the connection to addr, or answer it with an error if addr is unreachable
+    void forward(const std::string &addr, Pending p) {
+        Backend &b = backend_for(addr);
+        if (b.fd < 0 && !connect_backend(b)) {
+            auto it = clients.find(p.client_fd);
+            if (it != clients.end() && it->second.id == p.conn_id)
+                reply(it->second, p.seq, "ERR backend " + b.addr + " unavailable\n");
+            return;
+        }
+        b.outbuf += p.req;
+        b.inflight.push_back(std::move(p));
+        dirty_backends.insert(&b);
+    }
+
+    // ---------- backends ----------
+
+    Backend &backend_for(const std::string &addr) {
+        Backend &b = backends[addr];
+        if (b.addr.empty()) b.addr = addr;
+        return b;
+    }
+
+    bool connect_backend(Backend &b) {
+        size_t colon = b.addr.rfind(':');
+        if (colon == std::string::npos) {
+            log_error("bad backend address '" + b.addr + "'");
+            return false;
+        }
+        std::string host = b.addr.substr(0, colon), port = b.addr.substr(colon+1);
+        addrinfo hints{}; hints.ai_family = AF_INET; hints.ai_socktype = SOCK_STREAM;
+        addrinfo *res = nullptr;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0 || !res) {
+            log_error("cannot resolve backend " + b.addr);
+            return false;
+        }
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) { freeaddrinfo(res); log_error(std::string("socket: ") + strerror(errno)); return false; }
+        set_nonblocking(fd);
+        int rc = connect(fd, res->ai_addr, res->ai_addrlen);
+        freeaddrinfo(res);
+        if (rc < 0 && errno != EINPROGRESS) {
+            log_error("connect to backend " + b.addr + " failed: " + strerror(errno));
+            close(fd);
+            return false;
+        }
+        b.fd = fd;
+        b.connected = (rc == 0);
+        b.events = EPOLLIN | EPOLLOUT;  // EPOLLOUT reports connect completion
+        epoll_event ev{}; ev.events = b.events; ev.data.fd = fd;
+        if (epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            log_error(std::string("epoll_ctl ADD backend failed: ") + strerror(errno));
+            close(fd);
+            b.fd = -1;
+            return false;
+        }
+        backend_fds[fd] = &b;
+        log_info("Connecting to backend " + b.addr + " fd=" + std::to_string(fd));
+        return true;
+    }
+
+    // drop the connection and answer everything still outstanding on it
+    void fail_backend(Backend &b, const std::string &why) {
+        log_error("backend " + b.addr + ": " + why);
+        if (b.fd >= 0) {
+            backend_fds.erase(b.fd);
+            close(b.fd);
+        }
+        b.fd = -1;
+        b.connected = false;
+        b.events = 0;
+        b.outbuf.clear();
+        b.inbuf.clear();
+        dirty_backends.erase(&b);
+        std::string msg = "ERR backend " + b.addr + " unavailable\n";
+        std::deque<Pending> lost;
+        lost.swap(b.inflight);
+        for (auto &p: lost) {
+            if (p.probe) { probe_result(p.probe, b.addr, ""); continue; }
+            auto it = clients.find(p.client_fd);
+            if (it != clients.end() && it->second.id == p.conn_id) reply(it->second, p.seq, msg);
+        }
+    }
+
+    void on_backend_event(Backend &b, uint32_t evs) {
+        if (!b.connected && (evs & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+            int err = 0; socklen_t len = sizeof(err);
+            if (getsockopt(b.fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err != 0) {
+                fail_backend(b, std::string("connect failed: ") + strerror(err ? err : errno));
+                return;
+            }
+            b.connected = true;
+            log_info("Connected to backend " + b.addr);
+        }
+        if (evs & EPOLLIN) {
+            while (true) {
+                char buf[4096];
+                ssize_t r = recv(b.fd, buf, sizeof(buf), 0);
+                if (r > 0) {
+                    b.inbuf.append(buf, r);
+                    std::string line;
+                    while (next_line(b.inbuf, line)) {
+                        if (b.inflight.empty()) {
+                            log_error("unexpected reply from backend " + b.addr + ": '" + line + "'");
+                            continue;
+                        }
+                        Pending p = std::move(b.inflight.front());
+                        b.inflight.pop_front();
+                        if (p.probe) { probe_result(p.probe, b.addr, line); continue; }
+                        auto it = clients.find(p.client_fd);
+                        if (it == clients.end() || it->second.id != p.conn_id) continue;
+                        // proxy and nodes reload the ring at slightly different times; follow
+                        // one redirect to the named owner, keeping the client's seq
+                        if (!p.redirected && line.rfind("ERR MOVED ", 0) == 0) {
+                            std::string owner = line.substr(10);
+                            p.redirected = true;
+                            log_info("MOVED from " + b.addr + ", retrying on " + owner);
+                            forward(owner, std::move(p));
+                            continue;
+                        }
+                        reply(it->second, p.seq, line + "\n");
+                    }
+                } else if (r == 0) {
+                    fail_backend(b, "connection closed");
+                    return;
+                } else {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                    fail_backend(b, std::string("recv error: ") + strerror(errno));
+                    return;
+                }
+            }
+        }
+        if (evs & (EPOLLERR | EPOLLHUP)) {
+            fail_backend(b, "EPOLLERR/HUP");
+            return;
+        }
+        // a node removed from the ring is closed once its last reply is back
+        if (b.inflight.empty() && !node_in_use(b.addr)) {
+            retire_backend(b);
+            return;
+        }
+        if (evs & EPOLLOUT) flush_backend(b);
+    }
+
+    bool node_in_use(const std::string &addr) const {
+        return ring.contains(addr) || (cand.gen && cand.ring.contains(addr));
+    }
+
+    // close and forget a backend that is in no ring any more; b is invalid afterwards
+    void retire_backend(Backend &b) {
+        std::string addr = b.addr;
+        log_info("Closing backend " + addr + " (not in the ring)");
+        if (b.fd >= 0) { backend_fds.erase(b.fd); close(b.fd); }
+        dirty_backends.erase(&b);
+        backends.erase(addr);
+    }
+
+    void flush_backend(Backend &b) {
+        if (b.fd < 0) return;
+        if (b.connected) {
+            size_t off = 0;
+            while (off < b.outbuf.size()) {
+                ssize_t w = send(b.fd, b.outbuf.data() + off, b.outbuf.size() - off, MSG_NOSIGNAL);
+                if (w < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                    fail_backend(b, std::string("send failed: ") + strerror(errno));
+                    return;
+                }
+                off += (size_t)w;
+            }
+            b.outbuf.erase(0, off);
+        }
+        // keep EPOLLOUT only while connecting or while requests are still unsent
+        uint32_t want = EPOLLIN | ((!b.connected || !b.outbuf.empty()) ? (uint32_t)EPOLLOUT : 0u);
+        if (want != b.events) {
+            b.events = want;
+            set_events(b.fd, want);
+        }
+    }
+
+    // SIGHUP: build the new ring from cluster_nodes and send DBID to each of its nodes
+    // over the normal backend connections; the ring is swapped in by probe_result()
+    // once all of them agree, so the event loop never blocks on the check.
+    void reload() {
+        ProxyConfig ncfg = load_proxy_config_file(cfg_path);
+        HashRing nring = build_ring(split_list(ncfg.cluster_nodes), ncfg.cluster_vnodes);
+        if (nring.empty()) { log_error("reload: cluster_nodes is empty, keeping old ring"); return; }
+
+        cand = RingCandidate();
+        cand.gen = next_gen++;
+        cand.cfg = ncfg;
+        cand.ring = nring;
+        cand.deadline_ms = now_ms() + 2000;
+        uint64_t gen = cand.gen;
+        log_info("reload: checking DBID on " + std::to_string(nring.nodes().size()) + " nodes");
+        for (auto &node : nring.nodes()) {
+            Backend &b = backend_for(node);
+            if (b.fd < 0 && !connect_backend(b)) { probe_result(gen, node, ""); return; }
+            b.outbuf += "DBID\n";
+            b.inflight.push_back(Pending{-1, 0, 0, "DBID\n", false, gen});
+            dirty_backends.insert(&b);
+        }
+    }
+
+    // a DBID reply ("" if the node failed) for reload generation gen
+    void probe_result(uint64_t gen, const std::string &node, const std::string &reply) {
+        if (gen != cand.gen) return;  // superseded or already decided
+        if (reply.rfind("OK ", 0) != 0) {
+            log_error("reload: cannot read DBID from node " + node + (reply.empty() ? "" : ": " + reply)
+                      + ", keeping old ring");
+            cand = RingCandidate();
+            return;
+        }
+        cand.ids[node] = reply.substr(3);
+        if (cand.ids.size() < cand.ring.nodes().size()) return;
+
+        const std::string &first = cand.ids.begin()->second;
+        for (auto &kv : cand.ids) {
+            if (kv.second == first) continue;
+            log_error("reload: node " + kv.first + " uses DB '" + kv.second + "' but "
+                      + cand.ids.begin()->first + " uses '" + first
+                      + "'; cluster mode requires one shared DB, keeping old ring");
+            cand = RingCandidate();
+            return;
+        }
+        commit_ring();
+    }
+
+    // install the verified candidate ring. Consistent hashing means only the keys
+    // claimed by added (or released by removed) nodes change owner.
+    void commit_ring() {
+        const int samples = 10000;
+        int moved = 0;
+        for (int i=0;i<samples;i++) {
+            std::string k = "k" + std::to_string(i);
+            if (ring.node_for(k) != cand.ring.node_for(k)) moved++;
+        }
+        log_info("Ring reloaded: " + std::to_string(ring.nodes().size()) + " -> "
+                 + std::to_string(cand.ring.nodes().size()) + " nodes, "
+                 + std::to_string(moved * 100 / samples) + "% of sampled keys moved");
+        ring = cand.ring;
+        cfg.cluster_nodes = cand.cfg.cluster_nodes;
+        cfg.cluster_vnodes = cand.cfg.cluster_vnodes;
+        cand = RingCandidate();
+        close_unused_backends();
+    }
+
+    // close connections to nodes outside the ring that no client is waiting on (only
+    // stale DBID probes left at most); the rest close once drained. Not for use while
+    // handling an event of one of these backends.
+    void close_unused_backends() {
+        std::vector<Backend*> idle;
+        for (auto &kv : backends) {
+            auto &q = kv.second.inflight;
+            bool probes_only = std::all_of(q.begin(), q.end(), [](const Pending &p) { return p.probe != 0; });
+            if (!ring.contains(kv.first) && probes_only) idle.push_back(&kv.second);
+        }
+        for (Backend *b : idle) retire_backend(*b);
+    }
+};
+
+int main(int argc, char** argv) {
+    std::string cfg_path = "proxy.conf";
+    if (argc > 1) cfg_path = argv[1];
+
+    signal(SIGINT, sigint_handler);
+    signal(SIGTERM, sigint_handler);
+    signal(SIGHUP, sighup_handler);
+    signal(SIGPIPE, SIG_IGN);
+
+    Proxy proxy(cfg_path);
+    set_log_level(proxy.config().log_level);
+    log_info("Config: port=" + std::to_string(proxy.config().port) + " nodes=" + proxy.config().cluster_nodes
+             + " vnodes=" + std::to_string(proxy.config().cluster_vnodes));
+    if (!proxy.start()) return 1;
+    proxy.run();
+
+    log_info("Shutting down proxy...");
+    return 0;
+}
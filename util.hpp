@@ -8,9 +8,20 @@ inline uint64_t now_ms() {
         std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
+// log_level: 0 = off, 1 = error, 2 = info
+inline int g_log_level = 2;
+
+inline void set_log_level(const std::string &lvl) {
+    if (lvl == "off" || lvl == "none") g_log_level = 0;
+    else if (lvl == "error") g_log_level = 1;
+    else g_log_level = 2;
+}
+
 inline void log_info(const std::string &s) {
+    if (g_log_level < 2) return;
     std::cout << "[INFO] " << s << std::endl;
 }
 inline void log_error(const std::string &s) {
+    if (g_log_level < 1) return;
     std::cerr << "[ERROR] " << s << std::endl;
 }
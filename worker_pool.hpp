@@ -70,6 +70,66 @@ private:
         }
     }
 
+    // enable EPOLLOUT for a conn whose outq just gained data; caller holds ct->mtx
+    void arm_write_locked(Conn *cp, int fd) {
+        bool was_not_writing = !cp->want_write;
+        cp->want_write = true;
+        if (!was_not_writing) return;
+        epoll_event ne{};
+        ne.events = EPOLLIN | EPOLLOUT;
+        ne.data.fd = fd;
+        if (g_epoll_fd > 0) {
+            if (epoll_ctl(g_epoll_fd, EPOLL_CTL_MOD, fd, &ne) < 0) {
+                log_error("WORKER: epoll_ctl MOD enable EPOLLOUT failed for fd=" + std::to_string(fd));
+            } else {
+                log_info("WORKER: enabled EPOLLOUT for fd=" + std::to_string(fd));
+            }
+        } else {
+            log_error("WORKER: g_epoll_fd invalid");
+        }
+    }
+
+    // run one page of a SCAN and stream it to the client. If more rows remain the job is
+    // requeued behind other clients' work, or parked on the conn while its unread output
+    // is above scan_outq_high_kb (the reactor resumes it once the client catches up).
+    void handle_scan(Job &j) {
+        size_t page = (size_t)cfg.scan_chunk_rows;
+        if (j.remaining > 0 && (size_t)j.remaining < page) page = (size_t)j.remaining;
+
+        std::vector<std::pair<std::string,std::string>> rows;
+        std::string derr, chunk;
+        bool done = true;
+        if (!db->scan(j.key, j.cursor, page, rows, derr)) {
+            chunk = "ERR " + derr + "\n";
+        } else {
+            for (auto &r: rows) chunk += "ROW " + r.first + " " + r.second + "\n";
+            if (!rows.empty()) j.cursor = rows.back().first;
+            if (j.remaining > 0) j.remaining -= (int64_t)rows.size();
+            if (rows.size() < page) chunk += "END\n";
+            else if (j.remaining == 0) chunk += "END " + j.cursor + "\n";
+            else done = false;
+        }
+
+        bool requeue = false;
+        {
+            std::lock_guard<std::mutex> g(ct->mtx);
+            Conn* cp = ct->get_ptr_unlocked(j.client_fd);
+            if (!cp || cp->id != j.conn_id) {
+                log_info("WORKER: client gone during SCAN fd=" + std::to_string(j.client_fd));
+                return;
+            }
+            if (cp->deliver(j.seq, std::move(chunk), done)) arm_write_locked(cp, j.client_fd);
+            if (!done) {
+                if (cp->buffered_for(j.seq) > (size_t)cfg.scan_outq_high_kb * 1024) {
+                    cp->parked.push_back(j);
+                } else {
+                    requeue = true;
+                }
+            }
+        }
+        if (requeue) push_job(j);
+    }
+
     void worker_entry(int idx) {
         // set affinity for this thread if requested
         set_thread_affinity(idx);
@@ -89,6 +149,11 @@ private:
             uint64_t start = now_ms();
             std::string response;
 
+            if (j.type == Job::SCAN) {
+                handle_scan(j);
+                continue;
+            }
+
             if (j.type == Job::GET) {
                 std::string val;
                 bool hit = false;
@@ -107,6 +172,10 @@ private:
                         response = "MISS\n";
                     }
                 }
+            } else if (j.type == Job::DBID) {
+                std::string id, derr;
+                if (db->identity(id, derr)) response = "OK " + id + "\n";
+                else response = "ERR " + derr + "\n";
             } else { // PUT
                 std::string derr;
                 bool ok = db->put(j.key, j.value, derr);
@@ -121,29 +190,11 @@ private:
             {
                 std::lock_guard<std::mutex> g(ct->mtx);
                 Conn* cp = ct->get_ptr_unlocked(j.client_fd);
-                if (!cp) {
+                if (!cp || cp->id != j.conn_id) {
                     log_info("WORKER: client gone fd=" + std::to_string(j.client_fd));
                     continue;
                 }
-                bool was_not_writing = !cp->want_write;
-
-
-                cp->outq.push_back(response);
-                cp->want_write = true;
-                if (was_not_writing) {
-                    epoll_event ne{};
-                    ne.events = EPOLLIN | EPOLLOUT;
-                    ne.data.fd = j.client_fd;
-                    if (g_epoll_fd > 0) {
-                        if (epoll_ctl(g_epoll_fd, EPOLL_CTL_MOD, j.client_fd, &ne) < 0) {
-                            log_error("WORKER: epoll_ctl MOD enable EPOLLOUT failed for fd=" + std::to_string(j.client_fd));
-                        } else {
-                            log_info("WORKER: enabled EPOLLOUT for fd=" + std::to_string(j.client_fd));
-                        }
-                    } else {
-                        log_error("WORKER: g_epoll_fd invalid");
-                    }
-                }
+                if (cp->deliver(j.seq, std::move(response), true)) arm_write_locked(cp, j.client_fd);
             }
 
             (void)start; // keep variable if you want to compute worker time later